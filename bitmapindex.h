@@ -0,0 +1,182 @@
+#ifndef BITMAPINDEX_H
+#define BITMAPINDEX_H
+
+#include <vector>
+#include "heapfile.h"
+#include "bitmapscan.h"
+
+// A compressed set of 32-bit positions, after Roaring bitmaps.  The
+// positions are split by their high 16 bits into containers.  A
+// container of at most ARRAYMAX positions is a sorted array of their
+// low 16 bits; a fuller one is a bitmap of all 65536.  Either way a
+// container never takes more than 8K bytes, and sets combine container
+// by container, with word-wide operations between bitmaps.
+class RoaringBitmap
+{
+public:
+    // add x to the set
+    void add(const unsigned x);
+
+    // remove x from the set; false if it was not there
+    const bool remove(const unsigned x);
+
+    const bool contains(const unsigned x) const;
+
+    // number of positions in the set
+    const int count() const;
+
+    const bool empty() const { return containers.empty(); }
+    void clear() { containers.clear(); }
+
+    // keep the positions that are in other as well (AND)
+    RoaringBitmap & operator&=(const RoaringBitmap & other);
+
+    // add the positions of other (OR)
+    RoaringBitmap & operator|=(const RoaringBitmap & other);
+
+    // drop the positions that are in other (AND NOT)
+    RoaringBitmap & operator-=(const RoaringBitmap & other);
+
+    // call f on each position, in increasing order
+    template <class F> void forEach(F f) const
+    {
+        for (unsigned i = 0; i < containers.size(); i++)
+        {
+            const Container & c = containers[i];
+            unsigned base = (unsigned) c.key << 16;
+            if (c.bits.empty())
+            {
+                for (unsigned j = 0; j < c.array.size(); j++)
+                    f(base | c.array[j]);
+                continue;
+            }
+            for (unsigned w = 0; w < c.bits.size(); w++)
+                for (unsigned long long word = c.bits[w]; word != 0; word &= word - 1)
+                    f(base | (w * 64 + __builtin_ctzll(word)));
+        }
+    }
+
+    // append the set to out, and read it back from in, returning the
+    // first byte after it
+    void write(vector<char> & out) const;
+    const char* read(const char* in);
+
+private:
+    struct Container
+    {
+        unsigned short  key;    // high 16 bits of its positions
+        int             card;   // number of positions
+        vector<unsigned short> array;       // low 16 bits, if an array
+        vector<unsigned long long> bits;    // 1024 words, if a bitmap
+    };
+    vector<Container> containers;   // in order of key
+
+    // index of the container for key, or where it would go
+    const int find(const unsigned short key) const;
+};
+
+// The position of a record in a bitmap is its page number followed by
+// BITMAPSLOTBITS bits of slot number, so bitmaps hold records of pages
+// with up to 1 << BITMAPSLOTBITS slots, and of the first 4M pages
+const int BITMAPSLOTBITS = 10;
+
+inline const unsigned bitmapPosition(const RID & rid)
+{
+    return ((unsigned) rid.pageNo << BITMAPSLOTBITS) | rid.slotNo;
+}
+
+inline const RID bitmapRid(const unsigned pos)
+{
+    RID rid;
+    rid.pageNo = pos >> BITMAPSLOTBITS;
+    rid.slotNo = pos & ((1 << BITMAPSLOTBITS) - 1);
+    return rid;
+}
+
+// add the records of positions to rids, to fetch them in page order
+void addRids(const RoaringBitmap & positions, RIDBitmap & rids);
+
+// header page of a bitmap index file.  The bitmaps follow, one per
+// key, as a byte stream over a chain of data pages
+struct BitmapHdrPage
+{
+  char		relName[MAXNAMESIZE]; // relation the index is on
+  int		attrOffset;	// byte offset of key attribute in records
+  int		attrLength;	// length of key attribute
+  Datatype	attrType;	// datatype of key attribute
+  int		valueCnt;	// number of distinct keys
+  int		streamLen;	// bytes of bitmaps in the data pages
+  int		firstPage;	// first data page, -1 if none
+};
+
+struct BitmapDataPage
+{
+  int		nextPage;	// next data page, -1 if none
+  char		data[PAGESIZE - sizeof(int)];
+};
+
+struct BitmapShared;
+
+// Bitmap index over an attribute with few distinct values: for each
+// value, the set of records holding it, as a RoaringBitmap of their
+// positions.  Predicates on one or more such attributes are answered
+// by combining bitmaps, and only the records in the result need be
+// read.  The bitmaps are small enough to be kept in memory while the
+// index is open; they are read from the index file when it is first
+// opened and written back when the last BitmapIndex on it closes.
+// Lookups may run concurrently; inserts and deletes exclude each other
+// and lookups.
+
+class BitmapIndex
+{
+public:
+
+    // open the index on attribute (offset, length, type) of relName,
+    // creating it from the records of relName if it does not exist
+    BitmapIndex(const string & relName,
+                const int offset,
+                const int length,
+                const Datatype type,
+                Status & status);
+
+    ~BitmapIndex();
+
+    // add an entry; NONUNIQUEENTRY if it is there already, BADINDEXPARM
+    // if rid has a slot number the positions cannot hold
+    const Status insertEntry(const void* value, const RID & rid);
+
+    // remove an entry; RECNOTFOUND if there is none
+    const Status deleteEntry(const void* value, const RID & rid);
+
+    // the records whose key satisfies (key op value)
+    const Status lookup(const void* value, const Operator op,
+                        RoaringBitmap & result);
+
+    // every record in the index, to take complements against
+    const Status all(RoaringBitmap & result);
+
+    // number of distinct keys
+    const int valueCount();
+
+private:
+    File*	file;		// index file
+    BitmapShared* shared;	// bitmaps shared with other BitmapIndexes
+    int		length;		// key length
+    Datatype	type;		// key type
+
+    // key bytes as they are stored, so equal keys are equal bytes
+    const string keyOf(const void* value) const;
+    const int keyCmp(const char* a, const char* b) const;
+
+    // share the bitmaps of the file just opened, which must be of the
+    // index on attribute offset of relName
+    const Status load(const string & relName, const int offset);
+
+    // write the bitmaps to the index file
+    const Status save();
+};
+
+// remove the file of the bitmap index on attribute offset of relName
+const Status destroyBitmapIndex(const string & relName, const int offset);
+
+#endif
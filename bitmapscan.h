@@ -0,0 +1,84 @@
+#ifndef BITMAPSCAN_H
+#define BITMAPSCAN_H
+
+#include <map>
+#include <vector>
+#include "heapfile.h"
+
+// A set of RIDs kept as a bitmap of slot numbers for each data page,
+// in page order.  The RIDs an index scan returns go in in key order and
+// come out in physical order; bitmaps filled from several indexes can
+// be combined to find the records that satisfy all or any of their
+// conditions.
+class RIDBitmap
+{
+  friend class BitmapHeapScan;
+
+public:
+    // add rid to the set
+    void add(const RID & rid);
+
+    // add the RIDs that a started scan of index returns, then end it
+    template <class Index> const Status addScan(Index & index)
+    {
+        Status  status;
+        RID     rid;
+
+        while ((status = index.scanNext(rid)) == OK)
+            add(rid);
+        index.endScan();
+        return (status == NOMORERECS) ? OK : status;
+    }
+
+    // keep only the RIDs that are in other as well
+    void intersect(const RIDBitmap & other);
+
+    // add the RIDs of other
+    void unite(const RIDBitmap & other);
+
+    // number of RIDs in the set
+    const int count() const;
+
+    // number of pages they are on
+    const int pageCount() const { return pages.size(); }
+
+    void clear() { pages.clear(); }
+
+private:
+    // bit slotNo % 32 of word slotNo / 32 is set for each RID
+    map<int, vector<unsigned> > pages;
+};
+
+// Fetches the records of a RIDBitmap from the heap file in physical
+// order, so that each page is read and pinned once whatever order the
+// index returned the RIDs in.  RIDs of records deleted since the bitmap
+// was filled are skipped.
+class BitmapHeapScan : public HeapFile
+{
+public:
+
+    BitmapHeapScan(const string & name, Status & status);
+
+    ~BitmapHeapScan();
+
+    // start a scan of the records in bitmap, which must not change
+    // until the scan ends
+    const Status startScan(const RIDBitmap & bitmap);
+
+    // return RID of next record, FILEEOF after the last
+    const Status scanNext(RID & outRid);
+
+    // read current record, returning pointer and length
+    const Status getRecord(Record & rec);
+
+    // terminate the scan
+    const Status endScan();
+
+private:
+    const RIDBitmap* bitmap;    // RIDs being fetched, NULL if no scan
+    map<int, vector<unsigned> >::const_iterator pageIt; // page being fetched
+    int   nextSlot;             // first slot of it not looked at yet
+    Record curRecord;           // record last returned
+};
+
+#endif
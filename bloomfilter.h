@@ -0,0 +1,92 @@
+#ifndef BLOOMFILTER_H
+#define BLOOMFILTER_H
+
+#include <vector>
+#include "heapfile.h"
+
+// bytes per block of a blocked Bloom filter: one cache line
+const int BLOOMBLOCK = 64;
+
+// header page of a Bloom filter file.  The blocks of the filter follow
+// in dataPageCnt consecutive pages
+struct BloomHdrPage
+{
+  char		relName[MAXNAMESIZE]; // relation the filter is on
+  int		attrOffset;	// byte offset of key attribute in records
+  int		attrLength;	// length of key attribute
+  Datatype	attrType;	// datatype of key attribute
+  int		bitsPerKey;	// bits of filter per key it was sized for
+  int		blockCnt;	// number of blocks
+  int		keyCnt;		// keys added since it was built
+  int		firstPage;	// first data page
+  int		dataPageCnt;	// data pages in the file
+};
+
+struct BloomShared;
+
+// Blocked Bloom filter over one attribute of a heap file.  It answers
+// whether any record may have a key, with no false negatives and a
+// small rate of false positives, so that a lookup of an absent key
+// need not read the relation.  Each key sets k bits within a single
+// 64-byte block, which a lookup tests with one cache miss.  Keys are
+// only ever added: deleting records leaves their keys in the filter
+// until rebuild().  The filter is kept in memory while open, read from
+// its file when first opened and written back when the last
+// BloomFilter on it closes.
+
+class BloomFilter
+{
+public:
+
+    // open the filter on attribute (offset, length, type) of relName,
+    // creating it from the records of relName if it does not exist,
+    // with bitsPerKey bits for each record
+    BloomFilter(const string & relName,
+                const int offset,
+                const int length,
+                const Datatype type,
+                Status & status,
+                const int bitsPerKey = 10);
+
+    ~BloomFilter();
+
+    // add value to the filter
+    const Status insertEntry(const void* value, const RID & rid);
+
+    // keys cannot be taken out; this does nothing
+    const Status deleteEntry(const void* value, const RID & rid);
+
+    // false if no record has key value
+    const bool mayContain(const void* value);
+
+    // build the filter again from the records of the relation, sized
+    // for as many as it has now
+    const Status rebuild();
+
+    // keys added since the filter was built
+    const int keyCount();
+
+private:
+    File*	file;		// filter file
+    BloomShared* shared;	// filter shared with other BloomFilters
+    string	relName;	// relation the filter is on
+    int		offset;		// key offset
+    int		length;		// key length
+    Datatype	type;		// key type
+
+    const unsigned long long hash(const void* value) const;
+
+    // share the filter of the file just opened
+    const Status load();
+
+    // size the filter for keyCnt keys and add the keys of the relation
+    const Status build(const int keyCnt);
+
+    // write the filter to its file
+    const Status save();
+};
+
+// remove the Bloom filter on attribute offset of relName
+const Status destroyBloomFilter(const string & relName, const int offset);
+
+#endif
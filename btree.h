@@ -0,0 +1,222 @@
+#ifndef BTREE_H
+#define BTREE_H
+
+#include <shared_mutex>
+#include <vector>
+#include "heapfile.h"
+
+// an attribute a covering index carries in its leaf entries
+struct IncludeAttr
+{
+  int		offset;		// byte offset of attribute in records
+  int		length;		// its length
+};
+
+// attributes a leaf entry can carry besides the key
+const int MAXINCLUDE = 4;
+
+// header page of a B+tree index file
+struct BTreeHdrPage
+{
+  char		relName[MAXNAMESIZE]; // relation the index is on
+  int		attrOffset;	// byte offset of key attribute in records
+  int		attrLength;	// length of key attribute
+  Datatype	attrType;	// datatype of key attribute
+  int		unique;		// true if no two records share a key
+  int		rootPageNo;	// page number of root node
+  int		includeCnt;	// number of included attributes
+  IncludeAttr	include[MAXINCLUDE]; // included attributes, in entry order
+};
+
+// A node of the tree fills a page.  A leaf holds keyCnt (key, RID)
+// entries in order, each followed by its included attributes, if any.
+// An internal node holds keyCnt + 1 child page numbers separated by
+// keyCnt (key, RID) separators; child i + 1 holds the entries that are
+// not less than separator i.
+struct BTreeNode
+{
+  int		level;		// 0 for leaves, height above the leaves otherwise
+  int		keyCnt;		// number of entries (separators) in node
+  int		rightSib;	// next node on the same level, -1 if none
+  int		version;	// bumped whenever the node changes
+  char		data[PAGESIZE - 4 * sizeof(int)];
+};
+
+struct BTreeShared;
+
+// Disk-resident B+tree over one attribute of a heap file.  In a unique
+// index keys identify records; otherwise entries are ordered by key
+// and RID, so equal keys are allowed and each entry can be found
+// again.  Any number of BTreeIndex objects, in any number of threads,
+// may use the same index at once: readers and writers couple latches
+// on the way down (latch crabbing), and a writer keeps the latches of
+// only those nodes a split could still reach.  A covering index also
+// carries copies of other attributes in its leaf entries, so a query
+// that needs only those can be answered from the index alone.
+
+class BTreeIndex
+{
+public:
+
+    // open the index on attribute (offset, length, type) of relName.
+    // If it does not exist it is bulk loaded from the records of
+    // relName, with nodes filled to fillPct percent
+    BTreeIndex(const string & relName,
+               const int offset,
+               const int length,
+               const Datatype type,
+               const int unique,
+               Status & status,
+               const int fillPct = 100);
+
+    // open the covering index on the attribute that also carries the
+    // attributes of include, creating it as above if it does not
+    // exist.  An existing index must carry the same attributes; the
+    // constructor above opens it whatever it carries
+    BTreeIndex(const string & relName,
+               const int offset,
+               const int length,
+               const Datatype type,
+               const int unique,
+               const vector<IncludeAttr> & include,
+               Status & status,
+               const int fillPct = 100);
+
+    ~BTreeIndex();
+
+    // add an entry; NONUNIQUEENTRY if it is there already, or if the
+    // index is unique and value is.  included holds the values of the
+    // included attributes one after the other; BADINDEXPARM if they
+    // are missing
+    const Status insertEntry(const void* value, const RID & rid,
+                             const void* included = NULL);
+
+    // remove an entry; RECNOTFOUND if there is none
+    const Status deleteEntry(const void* value, const RID & rid);
+
+    // start a scan of the entries between lowValue and highValue.
+    // lowOp is GT or GTE and highOp LT or LTE; a NULL value leaves
+    // that end of the range open
+    const Status startScan(const void* lowValue, const Operator lowOp,
+                           const void* highValue, const Operator highOp);
+
+    // start a scan of the entries with key value
+    const Status startScan(const void* value);
+
+    // return RID of next entry in the range, NOMORERECS after the last
+    const Status scanNext(RID & outRid);
+
+    // index-only scan: as above, also returning in entry the key of
+    // the entry followed by its included attributes, without reading
+    // the relation.  entry is valid until the next call.  Updates a
+    // HeapFile has batched are seen once it has applied them
+    const Status scanNext(RID & outRid, Record & entry);
+
+    // attributes carried in the leaf entries
+    const vector<IncludeAttr> & included() const { return include; }
+
+    // bytes of included attributes per entry
+    const int includeLength() const { return includeLen; }
+
+    // copy the included attributes of record data to out
+    void includedOf(const char* data, char* out) const;
+
+    // where the attribute (offset, length) of records is in an entry
+    // returned by scanNext(), or -1 if the index does not carry it
+    const int entryOffset(const int offset, const int length) const;
+
+    // terminate the scan
+    const Status endScan();
+
+private:
+    File*	file;		// index file
+    int		headerPageNo;	// page number of header page
+    BTreeHdrPage* headerPage;	// pinned header page
+    bool	hdrDirtyFlag;	// true if header page has been updated
+    BTreeShared* shared;	// latches shared with other BTreeIndexes
+
+    int		length;		// key length
+    Datatype	type;		// key type
+    bool	unique;		// true if keys are unique
+    int		keyOffset;	// key offset in records
+    vector<IncludeAttr> include; // included attributes
+    int		includeLen;	// their total length
+    int		leafSize;	// bytes per leaf entry
+    int		nodeSize;	// bytes per internal separator and child
+    int		leafMax;	// entries per leaf
+    int		nodeMax;	// separators per internal node
+
+    // scan state.  Between calls the current leaf stays pinned but not
+    // latched; if it changed meanwhile the scan finds its place again
+    // from the last entry returned
+    bool	scanning;	// true between startScan() and endScan()
+    bool	scanDone;	// true once the range is exhausted
+    int		scanPageNo;	// leaf the scan is on, -1 if none
+    BTreeNode*	scanNode;	// that leaf, pinned
+    int		scanVersion;	// its version when last looked at
+    int		scanPos;	// entry last returned
+    bool	positioned;	// true once an entry has been returned
+    vector<char> lowKey;	// lower bound, empty if none
+    vector<char> highKey;	// upper bound, empty if none
+    Operator	lowOp;
+    Operator	highOp;
+    vector<char> lastKey;	// key, then included attributes, of entry
+				// last returned
+    RID		lastRid;	// RID of entry last returned
+
+    const int keyCmp(const char* a, const char* b) const;
+    const int entryCmp(const char* keyA, const RID & ridA,
+                       const char* keyB, const RID & ridB) const;
+
+    char* leafKey(BTreeNode* node, const int i) const
+        { return node->data + i * leafSize; }
+    const RID leafRid(const BTreeNode* node, const int i) const;
+    char* nodeKey(BTreeNode* node, const int i) const
+        { return node->data + sizeof(int) + i * nodeSize; }
+    const RID nodeRid(const BTreeNode* node, const int i) const;
+    const int nodeChild(const BTreeNode* node, const int i) const;
+
+    // number of entries of node (separators, if internal) that come
+    // before (key, rid), or before or at it if orEqual; with withRid
+    // false only keys are compared
+    const int search(BTreeNode* node, const char* key, const RID & rid,
+                     const bool withRid, const bool orEqual) const;
+
+    shared_mutex* latchOf(const int pageNo);
+
+    // descend to the leaf (key, rid) belongs in, latched as asked
+    const Status findLeaf(const char* key, const RID & rid,
+                          const bool withRid, const bool orEqual,
+                          const bool exclusive,
+                          int & pageNo, BTreeNode*& node);
+
+    // open or create the index; any included attributes do if include
+    // is NULL
+    void open(const string & relName, const int offset,
+              const vector<IncludeAttr>* include, Status & status,
+              const int fillPct);
+
+    // take in the index file just opened, if it is the one asked for
+    const Status load(const string & relName, const int offset,
+                      const vector<IncludeAttr>* include);
+
+    const Status splitLeaf(BTreeNode* node, const int pos,
+                           const char* entry, int & newPageNo,
+                           vector<char> & sepKey, RID & sepRid);
+    const Status splitNode(BTreeNode* node, const int pos,
+                           const char* key, const RID & rid, const int child,
+                           int & newPageNo, vector<char> & sepKey,
+                           RID & sepRid);
+    const Status scanSeek(BTreeNode* node, int & pos);
+
+    // sort the entries of relName and build the tree from the leaves up
+    const Status bulkLoad(const string & relName, const int offset,
+                          const int fillPct);
+    const Status buildLevels(const function<const Status (char*&)> & next,
+                             const int fillPct);
+};
+
+// remove the file of the index on attribute offset of relName
+const Status destroyBTreeIndex(const string & relName, const int offset);
+
+#endif
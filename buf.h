@@ -1,6 +1,7 @@
 #ifndef BUF_H
 #define BUF_H
 
+#include <mutex>
 #include "db.h"
 // define if debug output wanted
 //#define DEBUGBUF
@@ -105,6 +106,7 @@ private:
   BufHashTbl*    hashTable;  	// hash table mapping (File, page) to frame
   BufDesc*	 bufTable;  	// vector of status info, 1 per page
   BufStats	 bufStats;	// buffer pool statistics
+  mutex		 latch;		// serializes all buffer pool operations
 
   const Status allocBuf(int & frame);   // allocate a free frame.  
   const void releaseBuf(int frame); // return unused frame to end of list
@@ -126,6 +128,12 @@ public:
                         // allocates a new, empty page 
   const Status flushFile(const File* file); // writing out all dirty pages of the file
   const Status disposePage(File* file, const int PageNo); // dispose of page in file
+  const Status getPinCnt(File* file, const int PageNo, int& pinCnt);
+                        // pin count of page, 0 if not in buffer pool
+  const Status discardPages(File* file, const int firstPageNo);
+                        // drop frames of pages >= firstPageNo unwritten
+  const Status allocExtent(File* file, int& numPages, int& firstPageNo);
+                        // allocates numPages contiguous pages in file
   void  printSelf();
 
   const BufStats & getBufStats() const // get buffer pool usage
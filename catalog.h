@@ -0,0 +1,126 @@
+#ifndef CATALOG_H
+#define CATALOG_H
+
+#include "heapfile.h"
+
+// names of the catalog relations
+#define RELCATNAME   "relcat"
+#define ATTRCATNAME  "attrcat"
+
+// longest relation or attribute name, with its terminating NUL
+const int MAXNAME = 32;
+
+// longest string attribute
+const int MAXSTRINGLEN = 255;
+
+// The catalog describes every relation: relcat holds a RelDesc for
+// each, and attrcat an AttrDesc for each of its attributes.  Both are
+// heap files and describe themselves too.  The schemas of relations
+// looked up are cached in memory, so that a lookup finds them without
+// reading the catalog; changes through the catalog keep the cache in
+// step.
+
+// a relation, as held in relcat
+struct RelDesc
+{
+  char		relName[MAXNAME]; // relation name
+  int		attrCnt;	// number of attributes
+  int		recLen;		// length of its records
+};
+
+// an attribute of a relation, as held in attrcat
+struct AttrDesc
+{
+  char		relName[MAXNAME]; // relation the attribute belongs to
+  char		attrName[MAXNAME]; // attribute name
+  int		attrOffset;	// byte offset of attribute in records
+  int		attrLen;	// its length
+  Datatype	attrType;	// its datatype
+};
+
+// an attribute of a relation being created
+struct AttrInfo
+{
+  char		attrName[MAXNAME]; // attribute name
+  Datatype	attrType;	// its datatype
+  int		attrLen;	// its length
+};
+
+class RelCatalog : public HeapFile
+{
+public:
+
+    // open relcat
+    RelCatalog(Status & status);
+
+    ~RelCatalog();
+
+    // get the description of relation; RELNOTFOUND if there is none
+    const Status getInfo(const string & relation, RelDesc & record);
+
+    // add a relation description / remove that of relation
+    const Status addInfo(RelDesc & record);
+    const Status removeInfo(const string & relation);
+
+    // create relation as a heap file of records holding the attributes
+    // of attrList one after the other, and describe it in the catalog.
+    // RELEXISTS if the catalog has it already, DUPLATTR if two of its
+    // attributes share a name, NAMETOOLONG if a name does not fit,
+    // ATTRTOOLONG if an attribute or the record is too long
+    const Status createRel(const string & relation, const int attrCnt,
+                           const AttrInfo attrList[]);
+
+    // destroy relation, its indexes and its description
+    const Status destroyRel(const string & relation);
+
+    // build index of kind on attribute attrName of relation, or drop
+    // it and destroy its file.  INDEXEXISTS if there is one already
+    const Status addIndex(const string & relation, const string & attrName,
+                          const IndexKind kind, const int unique);
+    const Status dropIndex(const string & relation, const string & attrName,
+                           const IndexKind kind);
+};
+
+class AttrCatalog : public HeapFile
+{
+public:
+
+    // open attrcat
+    AttrCatalog(Status & status);
+
+    ~AttrCatalog();
+
+    // get the description of attribute attrName of relation;
+    // RELNOTFOUND or ATTRNOTFOUND if there is none
+    const Status getInfo(const string & relation, const string & attrName,
+                         AttrDesc & record);
+
+    // add an attribute description / remove that of attrName of relation
+    const Status addInfo(AttrDesc & record);
+    const Status removeInfo(const string & relation, const string & attrName);
+
+    // get the descriptions of all attributes of relation, in the order
+    // they lie in its records
+    const Status getRelInfo(const string & relation, vector<AttrDesc> & attrs);
+
+    // remove the descriptions of all attributes of relation
+    const Status dropRelation(const string & relation);
+};
+
+extern RelCatalog*  relCat;
+extern AttrCatalog* attrCat;
+
+// create the catalog relations, describing themselves.  FILEEXISTS if
+// there is a catalog already
+const Status createCatalog();
+
+// destroy the catalog relations, which must not be open
+const Status destroyCatalog();
+
+// start scan of relation, filtered by comparing attribute attrName with
+// the value at filter by op, the attribute being found in the catalog
+const Status startScan(HeapFileScan & scan, const string & relation,
+                       const string & attrName, const char* filter,
+                       const Operator op);
+
+#endif
@@ -3,6 +3,8 @@
 
 #include <sys/types.h>
 #include <functional>
+#include <mutex>
+#include <vector>
 #include "error.h"
 #include <string.h>
 using namespace std;
@@ -23,12 +25,17 @@ class File {
  public:
 
   Status allocatePage(int& pageNo);     // allocate a new page
+  const Status allocateExtent(int& numPages,
+                              int& firstPageNo); // allocate a run of pages
   const Status disposePage(const int pageNo);       // release space for a page
   const Status readPage(const int pageNo,
 		  Page* pagePtr) const;       // read page from file
   const Status writePage(const int pageNo,
 		   const Page* pagePtr);      // write page to file
+  const Status writePages(const int pageNo, const Page* pagePtr,
+                          const int numPages); // write a run of pages
   const Status getFirstPage(int& pageNo) const;     // returns pageNo of first page
+  const Status truncate(const int numPages);   // drop pages from numPages on
 
   bool operator == (const File & other) const
     {
@@ -106,11 +113,14 @@ class DB {
   const Status createFile(const string & fileName) ;  // create a new file
   const Status destroyFile(const string & fileName) ; // destroy a file, 
                                                            // release all space
+  const Status destroyFiles(const vector<string> & fileNames); // destroy
+                                  // all of them, or none if one is open
   const Status openFile(const string & fileName, File* & file);  // open a file
   const Status closeFile(File* file);         // close a file
 
  private:
   OpenFileHashTbl   openFiles;    // list of open files
+  mutex             latch;        // serializes use of openFiles
 };
 
 
@@ -0,0 +1,127 @@
+#ifndef HASHINDEX_H
+#define HASHINDEX_H
+
+#include <vector>
+#include "heapfile.h"
+
+// bucket page numbers per directory page
+const int DIRSLOTS = PAGESIZE / sizeof(int);
+
+// directory pages the header page can list, and the global depth they
+// allow (DIRSLOTS * HASHDIRPAGES == 1 << MAXDEPTH)
+const int HASHDIRPAGES = 128;
+const int MAXDEPTH = 15;
+
+// header page of an extendible hash index file
+struct HashHdrPage
+{
+  char		relName[MAXNAMESIZE]; // relation the index is on
+  int		attrOffset;	// byte offset of key attribute in records
+  int		attrLength;	// length of key attribute
+  Datatype	attrType;	// datatype of key attribute
+  int		unique;		// true if no two records share a key
+  int		depth;		// global depth: directory has 1 << depth slots
+  int		dirPageCnt;	// directory pages in use
+  int		dirPages[HASHDIRPAGES]; // page numbers of directory pages
+};
+
+// a page of the directory
+struct HashDirPage
+{
+  int		bucket[DIRSLOTS]; // bucket page number for each slot
+};
+
+// A bucket holds (key, RID) entries whose hash values agree in their
+// localDepth low-order bits.  Entries that cannot be told apart by
+// splitting, because they all hash alike, go to overflow pages of the
+// same layout chained from the bucket.
+struct HashBucket
+{
+  int		localDepth;	// hash bits shared by the entries
+  int		keyCnt;		// number of entries on this page
+  int		nextPage;	// next overflow page, -1 if none
+  char		data[PAGESIZE - 3 * sizeof(int)];
+};
+
+struct HashShared;
+
+// Disk-resident extendible hash index over one attribute of a heap
+// file, for equality lookups.  The directory and buckets are pages of
+// the index file read through the buffer pool, so a lookup costs a
+// directory page and a bucket page.  A full bucket splits in two,
+// doubling the directory first if its local depth has reached the
+// global depth.  Lookups may run concurrently; inserts and deletes
+// exclude each other and lookups.
+
+class HashIndex
+{
+public:
+
+    // open the index on attribute (offset, length, type) of relName,
+    // creating it from the records of relName if it does not exist
+    HashIndex(const string & relName,
+              const int offset,
+              const int length,
+              const Datatype type,
+              const int unique,
+              Status & status);
+
+    ~HashIndex();
+
+    // add an entry; NONUNIQUEENTRY if it is there already, or if the
+    // index is unique and value is.  DIROVERFLOW if the directory
+    // cannot grow any more
+    const Status insertEntry(const void* value, const RID & rid);
+
+    // remove an entry; RECNOTFOUND if there is none
+    const Status deleteEntry(const void* value, const RID & rid);
+
+    // start a scan of the entries with key value
+    const Status startScan(const void* value);
+
+    // return RID of next entry with the key, NOMORERECS after the last
+    const Status scanNext(RID & outRid);
+
+    // terminate the scan
+    const Status endScan();
+
+private:
+    File*	file;		// index file
+    int		headerPageNo;	// page number of header page
+    HashHdrPage* headerPage;	// pinned header page
+    bool	hdrDirtyFlag;	// true if header page has been updated
+    HashShared*	shared;		// latch shared with other HashIndexes
+
+    int		length;		// key length
+    Datatype	type;		// key type
+    bool	unique;		// true if keys are unique
+    int		entrySize;	// bytes per bucket entry
+    int		bucketMax;	// entries per bucket page
+
+    vector<RID>	scanRids;	// entries found by startScan()
+    int		scanPos;	// next of them to return
+
+    const unsigned hash(const char* key) const;
+    const bool keyEq(const char* a, const char* b) const;
+
+    // take in the index file just opened, if it is the one asked for
+    const Status load(const string & relName, const int offset);
+
+    // page number of the bucket for hash value h
+    const Status findBucket(const unsigned h, int & bucketNo);
+
+    // double the directory
+    const Status growDirectory();
+
+    // split the bucket for hash value h
+    const Status splitBucket(const unsigned h, const int bucketNo);
+
+    // write entries to bucket bucketNo, chaining overflow pages as needed
+    const Status fillBucket(const int bucketNo, const int localDepth,
+                            const vector<char> & entries);
+};
+
+// remove the file of the hash index on attribute offset of relName
+const Status destroyHashIndex(const string & relName, const int offset);
+
+#endif
@@ -22,6 +22,22 @@ const unsigned MAXNAMESIZE = 50;
 enum Datatype { STRING, INTEGER, FLOAT };    // attribute data types
 enum Operator { LT, LTE, EQ, GTE, GT, NE };  // scan operators
 
+// kinds of index; a Bloom filter is kept up to date like an index
+enum IndexKind { BTREEINDEX, HASHINDEX, BITMAPINDEX, BLOOMFILTER };
+
+// an index of a relation, kept up to date by the relation's HeapFiles
+struct IndexDesc
+{
+  int		attrOffset;	// byte offset of key attribute in records
+  int		attrLength;	// length of key attribute
+  Datatype	attrType;	// datatype of key attribute
+  int		unique;		// true if no two records share a key
+  IndexKind	kind;		// B+tree, hash, bitmap or Bloom filter
+};
+
+// indexes a relation can have
+const int MAXINDEXES = 8;
+
 struct FileHdrPage
 {
   char		fileName[MAXNAMESIZE];   // name of file
@@ -29,12 +45,48 @@ struct FileHdrPage
   int		lastPage;	// pageNo of last data page in file
   int		pageCnt;	// number of pages
   int		recCnt;		// record count
+  int		recLen;		// length of every record, 0 if they vary
+  int		indexCnt;	// number of indexes
+  IndexDesc	indexes[MAXINDEXES]; // the indexes
 };
 
+// name of the file of the index of kind on attribute offset of relName
+const string indexFileName(const string & relName, const int offset,
+                           const IndexKind kind);
+
+// leading bytes of a large record kept on its data page, where scans
+// can test them without reading the rest
+const int LARGEPREFIX = 128;
+
+const unsigned OVERFLOWDATA = PAGESIZE - 2 * sizeof(int);
+
+// page holding part of a record too large for a data page.  The pages
+// of a record are chained, and allocated in contiguous runs
+struct OverflowPage
+{
+  char		data[OVERFLOWDATA]; // piece of the record
+  int		length;		// bytes of data in use
+  int		nextPage;	// next page of the record, -1 if none
+};
+
+class RecordReader;
+
+// Relations stay open in a handle cache after the last HeapFile on them
+// closes, with their header pages pinned, until the cache needs the room
+// or they are destroyed.  closeRelations() closes those no HeapFile has
+// open, writing back their header pages and Bloom filters, and must be
+// called before the buffer manager is deleted.  FILEOPEN if some
+// relation is still open; the others are closed all the same
+const Status closeRelations();
+
+
+struct RelHandle;
+struct IndexBatch;
 
 // class definition of heapFile
 class HeapFile {
 protected:
+   RelHandle*	relation;       // entry in the relation handle cache
    File* 	filePtr;        // underlying DB File object
    FileHdrPage*  headerPage;	// pinned file header page in buffer pool
    int		headerPageNo;	// page number of header page
@@ -44,6 +96,46 @@ protected:
    int   	curPageNo;	// page number of pinned page
    bool  	curDirtyFlag;   // true if page has been updated
    RID   	curRec;         // rid of last record returned
+   IndexBatch*	indexBatch;     // open indexes and updates due to them
+
+   // bring the relation's indexes up to date with a record inserted at
+   // or deleted from rid.  Updates to non-unique indexes are batched;
+   // unique ones are updated at once, so that indexInsert() can refuse
+   // a duplicate key with NONUNIQUEENTRY
+   const Status indexInsert(const Record & rec, const RID & rid);
+   const Status indexDelete(const Record & rec, const RID & rid);
+
+   // open the indexes listed in the header page, if not open yet
+   const Status openIndexes();
+
+   // apply the batched updates to index i
+   const Status flushIndex(const int i);
+
+   // apply all batched updates and close the indexes
+   const Status closeIndexes();
+
+   // apply mutator to record rec at rid, keeping the indexes in step
+   const Status updateIndexed(Record & rec, const RID & rid,
+                              const function<void (Record & rec)> & mutator);
+
+   // remove records whose deletion no snapshot needs to see past any more
+   const Status purgeRecords(vector<RID> & rids);
+
+   // write the overflow pages of a large record
+   const Status writeOverflow(const char* data, const int length,
+                              int& firstPageNo);
+
+   // dispose of a chain of overflow pages
+   const Status freeOverflow(int pageNo);
+
+   // dispose of the overflow pages of those records of page that are large
+   const Status freeLarge(Page* page, const int* slotNos, const int cnt);
+
+   // copy bytes offset to offset + length of the large record at rid,
+   // whose prefix on the pinned page is rec, to out; INVALIDRECLEN if
+   // the record ends before
+   const Status readLarge(Page* page, const RID & rid, const Record & rec,
+                          const int offset, const int length, char* out);
 
 public:
 
@@ -56,13 +148,48 @@ public:
   // return number of records in file
   const int getRecCnt() const;
 
-  // given a RID, read record from file, returning pointer and length
+  // given a RID, read record from file, returning pointer and length.
+  // Of a large record, only the first LARGEPREFIX bytes are returned
   const Status getRecord(const RID &rid, Record & rec);
+
+  // position reader on the record given by RID, to stream all of it
+  const Status openRecord(const RID &rid, RecordReader & reader);
+
+  // read n records given by RID, visiting each page only once; callback
+  // is invoked with the index into rids of each record as it is read
+  const Status getRecords(const RID* rids, const int n,
+                          const function<void (const int i, Record & rec)> & callback);
+
+  // unlink and dispose of empty data pages.  if mergePages is true,
+  // sparse pages are also folded into their predecessor (changes RIDs)
+  const Status vacuum(const bool mergePages, int& pagesFreed);
+
+  // remove all records, releasing every data page but one in bulk.
+  // The relation's indexes are emptied too; FILEOPEN, with nothing
+  // changed, if one is in use
+  const Status truncate();
+
+  // add index to those maintained for the relation; INDEXEXISTS if it
+  // has one of that kind on the attribute already
+  const Status addIndex(const IndexDesc & index);
+
+  // drop the index of kind on attribute offset; NOINDEX if none
+  const Status dropIndex(const int offset, const IndexKind kind);
+
+  // apply all batched index updates
+  const Status flushIndexes();
+
+  // true if a Bloom filter on attribute (offset, length, type) shows
+  // that no record has value there
+  const bool keyAbsent(const int offset, const int length,
+                       const Datatype type, const char* value);
 };
 
 
 class HeapFileScan : public HeapFile
 {
+  friend class HeapFile;     // vacuum moves the stop of a scan
+
 public:
 
     HeapFileScan(const string & name, Status & status);
@@ -70,6 +197,11 @@ public:
     // end filtered scan
     ~HeapFileScan();
 
+    // filter the scan by comparing attribute (offset, length, type) of
+    // each record with the value at filter by op; NULL for no filter.
+    // The value is not copied but read at each record, so the caller
+    // may change it as the scan goes.  On a scan in progress the filter
+    // applies from the next record on
     const Status startScan(const int offset, 
                            const int length,  
                            const Datatype type, 
@@ -83,15 +215,31 @@ public:
     // return RID of next record that satisfies the scan 
     const Status scanNext(RID& outRid);
 
+    // return up to max RIDs (and records, if recs is non-NULL) of the
+    // next records that satisfy the scan. n is set to the number returned
+    const Status scanNextBatch(RID* rids, Record* recs, const int max, int& n);
+
     // read current record, returning pointer and length
     const Status getRecord(Record & rec);
 
+    // true if the current record is large, and getRecord() returns only
+    // its first LARGEPREFIX bytes
+    const bool isLarge() const { return curPage != NULL && curPage->isLarge(curRec); }
+
     // delete current record 
     const Status deleteRecord();
 
     // marks current page of scan dirty
     const Status markDirty();
 
+    // delete every record of the file that satisfies the scan predicate
+    const Status deleteWhere(int& numDeleted);
+
+    // apply mutator in place to every record that satisfies the predicate.
+    // A large record cannot be updated in place: INVALIDRECLEN
+    const Status updateWhere(const function<void (Record & rec)> & mutator,
+                             int& numUpdated);
+
 private:
     int   offset;            // byte offset of filter attribute
     int   length;            // length of filter attribute
@@ -105,11 +253,56 @@ private:
     // scan to be rolled back to the following
     int   markedPageNo;	// page number of pinned page
     RID   markedRec;         // rid of last record returned
+    bool  markedWrapped;     // wrapped flag at time of markScan()
+
+    // scan sharing: a scan that joins one already in progress starts at
+    // that scan's page and wraps around to pick up the pages it missed
+    bool  scanStarted;       // true once the scan has been positioned
+    int   startPageNo;       // page the scan stops at after wrapping
+    int   joinPageNo;        // page a scan joining this one starts on
+    bool  wrapped;           // true after wrapping to the first page
+    int   snapshot;          // MVCC snapshot the scan reads (see mvcc.h)
+    bool  absent;            // true if a Bloom filter rules out every record
+
+    // a filter on a large record may need to read its overflow pages
+    const bool matchRec(const Record & rec, Page* page, const RID & rid);
+    const Status attachScan();   // position a new scan
+    const Status nextScanPage(); // advance to the next page, maybe wrapping
+};
+
+
+// Streams a record, large or not, as a sequence of chunks that point
+// straight into pinned buffer frames; no copy of the record is made.
+// A chunk stays valid until the next call to nextChunk() or close()
+class RecordReader
+{
+  friend class HeapFile;
+
+public:
+    RecordReader();
+    ~RecordReader();
+
+    // return the next piece of the record, or FILEEOF after the last
+    const Status nextChunk(const char*& chunk, int& length);
+
+    // return length of the whole record
+    const int getLength() const { return recLength; }
+
+    // let go of the page holding the current chunk
+    const Status close();
 
-    const bool matchRec(const Record & rec) const;
+private:
+    File* file;              // file the record is in
+    int   pinnedPageNo;      // page holding the current chunk, -1 if none
+    const char* prefix;      // part on the data page, until returned
+    int   prefixLen;         // length of that part
+    int   nextPageNo;        // next overflow page, -1 if none
+    int   recLength;         // length of the whole record
 };
 
 
+struct InsertShared;
+
 class InsertFileScan : public HeapFile
 {
 public:
@@ -119,8 +312,76 @@ public:
     // end filtered scan
     ~InsertFileScan();
 
-    // insert record into file, returning its RID
+    // insert record into file, returning its RID.  Records too large
+    // for a page are spread over overflow pages
     const Status insertRecord(const Record & rec, RID& outRid); 
+
+    // return number of records in file, including this scan's inserts
+    const int getRecCnt() const;
+
+private:
+    InsertShared* shared;    // state shared with other inserters
+    int   pendingRecs;       // inserts not yet counted in header page
+
+    const Status nextTarget(); // switch to a fresh page to insert into
+};
+
+
+// pages an AppendFileScan fills in memory before writing them out
+const int SEGMENTPAGES = 64;
+
+// Append-only inserter for relations records are never deleted from.
+// Records are packed into a segment of pages held in memory, which is
+// written to the file with one write when it fills up, on flush() and
+// when the scan is deleted.  Flushed records are ordinary records of
+// the relation; those still in the segment can only be read through
+// this scan's getRecord().
+class AppendFileScan : public HeapFile
+{
+public:
+
+    // the segment holds segmentPages pages
+    AppendFileScan(const string & name, Status & status,
+                   const int segmentPages = SEGMENTPAGES);
+
+    // flush the segment and close the file
+    ~AppendFileScan();
+
+    // append record to file, returning its RID
+    const Status insertRecord(const Record & rec, RID& outRid);
+
+    // write out the records appended so far
+    const Status flush();
+
+    // given a RID, read record, whether flushed or not
+    const Status getRecord(const RID & rid, Record & rec);
+
+    // return number of records in file, including unflushed ones
+    const int getRecCnt() const;
+
+private:
+    InsertShared* shared;    // state shared with other inserters
+    int   segPages;          // pages a segment holds
+    Page* segment;           // pages being filled, in file order
+    int   segFirstPageNo;    // page number of segment[0]
+    int   segSize;           // pages allocated to the segment
+    int   segUsed;           // pages of the segment holding records
+    int   pendingRecs;       // records in the segment
+};
+
+
+// A relation held still while an index of it is built: inserts under
+// way are finished and appended segments flushed first, and no record
+// is inserted or appended while the barrier is open.  A thread must not
+// open one on a relation it is inserting or appending into
+class InsertBarrier : public HeapFile
+{
+public:
+
+    InsertBarrier(const string & name, Status & status);
+
+    // let inserts go on
+    ~InsertBarrier();
 };
 
 #endif
@@ -0,0 +1,96 @@
+#ifndef MVCC_H
+#define MVCC_H
+
+#include <string>
+#include <map>
+#include <set>
+#include <atomic>
+#include <mutex>
+#include <vector>
+using namespace std;
+
+#include "page.h"
+#include "db.h"
+
+// Multi-version concurrency control for heap files.
+//
+// Every change to a record (insert, delete, in-place update) is stamped
+// with a commit time from a global clock, and every HeapFileScan takes a
+// snapshot of the clock when it starts.  Version information is kept in
+// memory, per open file, and only for records changed while snapshots of
+// that file are open; a record without an entry is visible to everyone.
+// While a snapshot may still need it, a deleted record stays on its page
+// (it is only marked deleted here) and the image of a record from before
+// an in-place update is kept here.  Once the last snapshot that could
+// see an old version ends, the version is dropped and logically deleted
+// records are handed back to the heap file to be removed for real.
+// The store is shared by all threads and latches itself.
+
+// version information for one record
+struct RecVersion
+{
+  int	xmin;		// commit time of insert, 0 if older than all snapshots
+  int	xmax;		// commit time of delete, 0 if not deleted
+  vector<pair<int, vector<char> > > before; // (update time, prior image)
+};
+
+// per file: open snapshots and versioned records
+struct FileVersions
+{
+  multiset<int>			snapshots; // snapshot times of open scans
+  map<pair<int,int>, RecVersion> recs;	   // keyed by (pageNo, slotNo)
+};
+
+class VersionStore
+{
+private:
+  int				clock;	// last commit time handed out
+  atomic<int>			numRecs; // versioned records in all files
+  atomic<int>			numSnapshots; // open snapshots of all files
+  mutable mutex			latch;	// protects clock and files
+  map<const File*, FileVersions> files;
+
+  RecVersion* find(const File* file, const RID & rid);
+  RecVersion & entry(const File* file, const RID & rid);
+  const bool lookup(const File* file, const RID & rid, const int snapshot,
+                    Record & rec);
+
+public:
+  VersionStore();
+
+  // start / end a snapshot of file.  endSnapshot() returns the RIDs of
+  // logically deleted records that no open snapshot can see any more;
+  // the caller must remove them from their pages
+  const int beginSnapshot(const File* file);
+  void endSnapshot(const File* file, const int snapshot, vector<RID> & purge);
+
+  // true if changes to file must be versioned, i.e. if snapshots other
+  // than the caller's own (ownSnapshots of them) are open on it
+  const bool versioning(const File* file, const int ownSnapshots = 0) const;
+
+  // record a change to a record made at a fresh commit time.  Only to be
+  // called if versioning() says so
+  void noteInsert(const File* file, const RID & rid);
+  void noteDelete(const File* file, const RID & rid);
+  void noteUpdate(const File* file, const RID & rid, const Record & before);
+
+  // decide whether snapshot can see the record at rid, whose current
+  // image is rec.  If it can, rec is switched to the image the snapshot
+  // should see.  The latest state (no snapshot) is asked for with
+  // snapshot == LATEST
+  const bool visible(const File* file, const RID & rid, const int snapshot,
+                     Record & rec)
+  {
+    // nearly always nothing is versioned; keep that case cheap
+    return numRecs == 0 || lookup(file, rid, snapshot, rec);
+  }
+
+  // discard all version information of file (after it was emptied)
+  void forget(const File* file);
+};
+
+const int LATEST = 0x7fffffff;
+
+extern VersionStore versions;
+
+#endif
@@ -23,6 +23,22 @@ struct slot_t {
         short	length;  // equals -1 if slot is not in use
 };
 
+// set in slot_t::length for the stub of a large record
+const short LARGEREC = 0x4000;
+
+// A record too large for a page is stored as a stub: its first bytes,
+// followed by this trailer, with the rest of the record in a chain of
+// overflow pages
+struct LargeStub
+{
+  int length;    // length of the whole record
+  int firstPage; // first overflow page
+};
+
+// page formats, kept in the dummy field of a page
+const short SLOTTEDPAGE = 0;  // variable-length records and a slot array
+const short FIXEDPAGE = 1;    // fixed-length records and a slot bitmap
+
 const unsigned PAGESIZE = 1024;
 const unsigned DPFIXED= sizeof(slot_t)+4*sizeof(short)+2*sizeof(int);
 const unsigned PAGEDATASIZE = PAGESIZE-DPFIXED+sizeof(slot_t);
@@ -34,6 +50,12 @@ const unsigned PAGEDATASIZE = PAGESIZE-DPFIXED+sizeof(slot_t);
 // array cannot be compacted.  Notice, this class does not keep
 // the records align, relying instead on upper levels to take
 // care of non-aligned attributes
+//
+// A page initialized with a record length uses a fixed-length format
+// instead: data[] holds a validity bitmap, padded to a multiple of 8
+// bytes, followed by an array of record slots.  slotCnt is the number
+// of slots, freePtr the record length and freeSpace the bytes left in
+// free slots.  Deleting a record only clears its bit.
 
 class Page {
 private:
@@ -42,12 +64,18 @@ private:
     short	slotCnt; // number of slots in use;
     short	freePtr; // offset of first free byte in data[]
     short	freeSpace; // number of bytes free in data[]
-    short	dummy;	// for alignment purposes
+    short	dummy;	// page format (SLOTTEDPAGE or FIXEDPAGE)
     int		nextPage; // forwards pointer
     int		curPage;  // page number of current pointer
 
+    // fixed-length format helpers
+    const int mapSize() const { return (slotCnt + 63) / 64 * 8; }
+    char* fixedRecord(const int slotNo) { return &data[mapSize() + slotNo * freePtr]; }
+    const bool isSet(const int slotNo) const { return data[slotNo >> 3] & (1 << (slotNo & 7)); }
+
 public:
-    void init(const int pageNo); // initialize a new page
+    // initialize a new page, for records of length recLen if it is > 0
+    void init(const int pageNo, const int recLen = 0);
     void dumpPage() const;       // dump contents of a page
 
     const Status getNextPage(int& pageNo) const; // returns value of nextPage
@@ -57,9 +85,26 @@ public:
     // inserts a new record (rec) into the page, returns RID of record 
     const Status insertRecord(const Record & rec, RID& rid);
 
+    // inserts rec after the last slot without looking for a free one;
+    // for pages no record has been deleted from
+    const Status appendRecord(const Record & rec, RID& rid);
+
+    // inserts the stub of a large record: its leading bytes and trailer
+    const Status insertLarge(const Record & prefix, const LargeStub & stub,
+                             RID& rid);
+
+    // true if rid is the stub of a large record
+    const bool isLarge(const RID & rid) const;
+
+    // returns the trailer of the large record with RID rid
+    const Status getStub(const RID & rid, LargeStub & stub);
+
     // delete the record with the specified rid
     const Status deleteRecord(const RID & rid);
 
+    // delete cnt records, given by slot number, with a single compaction
+    const Status deleteRecords(const int* slotNos, const int cnt);
+
     // returns RID of first record on page
     // returns  NORECORDS if page contains no records.  Otherwise, returns OK
     const Status firstRecord(RID& firstRid) const;
@@ -68,7 +113,8 @@ public:
     // returns ENDOFPAGE if no more records exist on the page
     const Status nextRecord (const RID & curRid, RID& nextRid) const;
 
-    // returns reference to record with RID rid
+    // returns reference to record with RID rid.  For a large record
+    // this is the part of it kept on the page
     const Status getRecord(const RID & rid, Record & rec);
 };
 
@@ -0,0 +1,181 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include <vector>
+#include "heapfile.h"
+
+struct RunFile;
+struct RunMerge;
+
+// A key normalized into an unsigned integer that orders as the key
+// does: a signed integer with its sign bit flipped, a float with its
+// sign bit flipped if positive and every bit if negative, or the first
+// NORMBYTES bytes of a string, zero after its end.  Strings longer than
+// that may tie where the keys do not
+const int NORMBYTES = sizeof(unsigned long long);
+
+const unsigned long long normalizeKey(const char* key, const Datatype type,
+                                      const int length);
+
+// a record being sorted in memory, with its key normalized
+struct SortItem
+{
+  unsigned long long key;	// normalized key
+  Record	rec;		// the record
+};
+
+// Sort items by normalized key with a least significant digit first
+// radix sort, a byte at a time, skipping bytes all keys share.  Strings
+// longer than NORMBYTES that tie are then sorted the same way on their
+// next NORMBYTES bytes at offset, and so on.  Items with equal keys
+// keep their order
+void radixSort(SortItem* items, const int n, const int offset,
+               const int length, const Datatype type);
+
+// External merge sort of a heap file on one attribute, within a budget
+// of memPages pages of memory, by up to threads threads.  The records
+// are read memPages - threads pages' worth at a time, and each thread
+// sorts a slice of them by radix sort on normalized keys.  If they do
+// not all fit, each slice is written to a temporary heap file as a run,
+// a page at a time; otherwise the slices are merged in memory.  Runs
+// are merged up to memPages / threads - 1 at a time, each merge reading
+// one page of each run and writing one page, by a loser tree that finds the next record with one comparison
+// per level.  Passes merge runs into longer ones, the threads taking a
+// merge each, until one merge can take them all.  With more than one
+// thread that last merge is split into key ranges by splitters sampled
+// from the runs, and the threads merge a range each.  The output is streamed through next().
+// Records with equal keys come out in the order they were read.
+// Records must fit on a data page.
+
+class SortedFile
+{
+public:
+
+    // sort the records of fileName on attribute (offset, length, type).
+    // BADSORTPARM if the attribute makes no sense, INSUFMEM if memPages
+    // is too few for each thread to merge, INVALIDRECLEN if a record is
+    // too large for a data page
+    SortedFile(const string & fileName,
+               const int offset,
+               const int length,
+               const Datatype type,
+               const int memPages,
+               Status & status,
+               const int threads = 1);
+
+    // remove the temporary files
+    ~SortedFile();
+
+    // return the next record in order, FILEEOF after the last.  rec is
+    // valid until the next call
+    const Status next(Record & rec);
+
+    // number of runs the records were sorted in
+    const int runCount() const { return runCnt; }
+
+private:
+    string	fileName;	// file being sorted
+    int		offset;		// key offset
+    int		length;		// key length
+    Datatype	type;		// key type
+    int		memPages;	// pages of memory to use
+    int		threads;	// threads to use
+
+    vector<char> arena;		// records read but not yet in a run
+    int		arenaUsed;	// bytes of arena holding them
+    vector<SortItem> items;	// those records, in order once sorted
+    unsigned	nextItem;	// next record to return, if all fit
+    vector<RunFile*> runs;	// runs not yet merged, in the order read
+    int		runCnt;		// runs formed
+    RunMerge*	merge;		// the last merge, streaming
+
+    const int keyCmp(const char* a, const char* b) const;
+
+    // sort the records in memory in slices, one for each thread, by
+    // key and then arrival.  Returns where the slices begin and end
+    const vector<int> sortSlices();
+
+    // sort the records in memory, merging the slices by key range
+    void sortInMemory();
+
+    // write the records in memory to new runs, a slice in each
+    const Status writeRuns();
+
+    // merge the records of inputs with keys from low up to high (NULL
+    // for no bound) into a new run
+    const Status mergeRuns(const vector<RunFile*> & inputs,
+                           const char* low, const char* high, RunFile*& out);
+
+    // start a merge of the records of inputs in the same range
+    const Status startMerge(const vector<RunFile*> & inputs,
+                            const char* low, const char* high, RunMerge*& m);
+
+    // merge the runs into one run for each thread, holding a key range
+    const Status partitionRuns();
+};
+
+// write the records of fileName to the new heap file outName, sorted on
+// attribute (offset, length, type) with memPages pages of memory and up
+// to threads threads
+const Status sortHeapFile(const string & fileName,
+                          const string & outName,
+                          const int offset,
+                          const int length,
+                          const Datatype type,
+                          const int memPages,
+                          const int threads = 1);
+
+// The k records of a heap file with the smallest keys on one attribute,
+// or the largest if descending, without sorting the rest.  A heap holds
+// the best k found so far, and once it is full the key of the worst of
+// them bounds the scan: the scan's filter points at it, so the bound
+// tightens as the heap does and the scan returns only records that
+// would enter the heap.  Of records with equal keys the ones read first
+// are kept, and they come out in the order they were read.  Of a large
+// record only its first LARGEPREFIX bytes are kept.
+
+class TopKScan
+{
+public:
+
+    // find the k records of fileName with the smallest or largest
+    // values of attribute (offset, length, type).  BADSORTPARM if the
+    // attribute makes no sense or k < 1
+    TopKScan(const string & fileName,
+             const int offset,
+             const int length,
+             const Datatype type,
+             const int k,
+             const bool descending,
+             Status & status);
+
+    // return the next record in order, FILEEOF after the last.  rec is
+    // valid as long as the TopKScan
+    const Status next(Record & rec);
+
+    // number of records the scan returned, that the heap had to look at
+    const int candidates() const { return candidateCnt; }
+
+private:
+    struct Entry
+    {
+      unsigned long long key;	// normalized key, complemented if descending
+      int	seq;		// order the record was read in
+      int	slot;		// index of the record in recs
+    };
+
+    int		offset;		// key offset
+    int		length;		// key length
+    Datatype	type;		// key type
+    bool	descending;	// true if the largest keys are wanted
+    vector<Entry> heap;		// the best records so far, the worst on top
+    vector<vector<char> > recs;	// their contents
+    vector<char> bound;		// key of the worst, once the heap is full
+    int		candidateCnt;	// records returned by the scan
+    unsigned	nextEntry;	// next record to return
+
+    // true if entry a comes before entry b in the output
+    const bool before(const Entry & a, const Entry & b) const;
+};
+
+#endif